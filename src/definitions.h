@@ -97,6 +97,9 @@
 #include "id3.h"
 #include "mp3.h"
 #include "signals.h"
+#include "station.h"
+#include "stats.h"
+#include "realtime.h"
 #include "reencode.h"
 #include "ices_config.h"
 #include "playlist/playlist.h"
@@ -135,6 +138,10 @@ double rg_get_track_gain(void);
 #define ICES_DEFAULT_VERBOSE 0
 #define ICES_DEFAULT_REENCODE 0
 #define ICES_DEFAULT_CUEFILE 0
+#define ICES_DEFAULT_STATS 0
+#define ICES_DEFAULT_SCHEDULER ices_scheduler_other_e
+#define ICES_DEFAULT_RT_PRIORITY 0
+#define ICES_DEFAULT_LOCK_MEMORY 0
 #define ICES_EXIT_SUCCESS 0
 #define ICES_EXIT_FAILURE 1
 
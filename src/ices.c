@@ -31,6 +31,10 @@ int main(int argc, char **argv) {
 	 * ices_util_get_argc() and argv */
 	ices_util_set_args(argc, argv);
 
+	/* With several config files, fork one station for each. Only the
+	 * stations return from here. */
+	ices_station_initialize();
+
 	/* Setup all options, and initialize all submodules */
 	ices_setup_initialize();
 
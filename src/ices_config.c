@@ -29,7 +29,7 @@
 #include <libxml/xmlmemory.h>
 
 /* Private function declarations */
-static int parse_file(const char *configfile, ices_config_t *ices_config);
+static int parse_file(const char *configfile, ices_config_t *ices_config, int streams_only);
 static void parse_playlist_node(xmlDocPtr doc, xmlNsPtr ns, xmlNodePtr cur, ices_config_t *ices_config);
 static void parse_execution_node(xmlDocPtr doc, xmlNsPtr ns, xmlNodePtr cur, ices_config_t *ices_config);
 static void parse_server_node(xmlDocPtr doc, xmlNsPtr ns, xmlNodePtr cur,
@@ -53,11 +53,28 @@ int ices_xml_parse_config_file(ices_config_t *ices_config, const char *configfil
 	xmlKeepBlanksDefault(0);
 
 	/* Parse the file and be happy */
-	return parse_file(configfile, ices_config);
+	return parse_file(configfile, ices_config, 0);
+}
+
+/* Parse only the Stream nodes of configfile into ices_config->streams,
+ * which must hold one preallocated stream. Used to reload a running ices,
+ * where playlist and execution settings can't change. */
+int ices_xml_parse_config_streams(ices_config_t *ices_config, const char *configfile) {
+	char namespace[1024];
+
+	if (!ices_util_verify_file(configfile)) {
+		ices_log_error("XML Parser Error: Could not open configfile. [%s]  Error: [%s]", configfile, ices_util_strerror(errno, namespace, 1024));
+		return 0;
+	}
+
+	LIBXML_TEST_VERSION
+	xmlKeepBlanksDefault(0);
+
+	return parse_file(configfile, ices_config, 1);
 }
 
 /* I hope you can tell this is my first try at xml and libxml :)  */
-static int parse_file(const char *configfile, ices_config_t *ices_config) {
+static int parse_file(const char *configfile, ices_config_t *ices_config, int streams_only) {
 	xmlDocPtr doc;
 	xmlNsPtr ns;
 	xmlNodePtr cur;
@@ -126,7 +143,9 @@ static int parse_file(const char *configfile, ices_config_t *ices_config) {
 			parse_stream_node(doc, ns, cur->xmlChildrenNode, stream);
 
 			nstreams++;
-		} else if (xmlstrcmp(cur->name, "Playlist") == 0)
+		} else if (streams_only)
+			continue;
+		else if (xmlstrcmp(cur->name, "Playlist") == 0)
 			parse_playlist_node(doc, ns, cur->xmlChildrenNode, ices_config);
 		else if (xmlstrcmp(cur->name, "Execution") == 0)
 			parse_execution_node(doc, ns, cur->xmlChildrenNode, ices_config);
@@ -235,6 +254,24 @@ static void parse_execution_node(xmlDocPtr doc, xmlNsPtr ns, xmlNodePtr cur,
 			ices_config->verbose = atoi(ices_xml_read_node(doc, cur));
 		else if (xmlstrcmp(cur->name, "CueFile") == 0)
 			ices_config->cuefile = atoi(ices_xml_read_node(doc, cur));
+		else if (xmlstrcmp(cur->name, "StatsFile") == 0)
+			ices_config->stats = atoi(ices_xml_read_node(doc, cur));
+		else if (xmlstrcmp(cur->name, "Scheduler") == 0) {
+			unsigned char *str = (unsigned char *)ices_xml_read_node(doc, cur);
+
+			if (str && (xmlstrcasecmp(str, "fifo") == 0))
+				ices_config->scheduler = ices_scheduler_fifo_e;
+			else if (str && (xmlstrcasecmp(str, "rr") == 0))
+				ices_config->scheduler = ices_scheduler_rr_e;
+			else
+				ices_config->scheduler = ices_scheduler_other_e;
+		} else if (xmlstrcmp(cur->name, "RealtimePriority") == 0)
+			ices_config->rt_priority = atoi(ices_xml_read_node(doc, cur));
+		else if (xmlstrcmp(cur->name, "CPUAffinity") == 0) {
+			ices_util_free(ices_config->cpu_affinity);
+			ices_config->cpu_affinity = ices_util_strdup(ices_xml_read_node(doc, cur));
+		} else if (xmlstrcmp(cur->name, "LockMemory") == 0)
+			ices_config->lock_memory = atoi(ices_xml_read_node(doc, cur));
 		else if (xmlstrcmp(cur->name, "BaseDirectory") == 0) {
 			if (ices_config->base_directory)
 				ices_config->base_directory =
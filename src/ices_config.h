@@ -20,3 +20,4 @@
 
 /* Public function declarations */
 int ices_xml_parse_config_file(ices_config_t *ices_config, const char *configfile);
+int ices_xml_parse_config_streams(ices_config_t *ices_config, const char *configfile);
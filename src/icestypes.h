@@ -35,6 +35,12 @@ typedef enum {
 	ices_playlist_perl_e
 } playlist_type_t;
 
+typedef enum {
+	ices_scheduler_other_e,
+	ices_scheduler_fifo_e,
+	ices_scheduler_rr_e
+} scheduler_type_t;
+
 typedef struct ices_stream_St {
 	shout_t* conn;
 	time_t connect_delay;
@@ -125,6 +131,11 @@ typedef struct {
 	int verbose;
 	int reencode;
 	int cuefile;
+	int stats;
+	scheduler_type_t scheduler;
+	int rt_priority;
+	char *cpu_affinity;
+	int lock_memory;
 	char *configfile;
 	char *base_directory;
 	FILE *logfile;
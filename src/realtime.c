@@ -0,0 +1,199 @@
+/* realtime.c
+ * - Real-time scheduling, CPU pinning and memory locking
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ */
+
+/* On a busy host most of the jitter in the pipeline comes from being
+ * scheduled out or from page faults, not from ices itself. These settings
+ * let the streaming process ask for a real-time policy, stay on a given
+ * set of CPUs and keep its memory resident. Every one of them needs
+ * privileges ices usually doesn't have, so failures are logged and ices
+ * carries on with whatever it got. */
+
+#include "definitions.h"
+
+#ifdef HAVE_SCHED_H
+#include <sched.h>
+#endif
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+extern ices_config_t ices_config;
+
+/* Private function declarations */
+static void realtime_set_scheduler(void);
+static void realtime_set_affinity(void);
+static void realtime_lock_memory(void);
+static void realtime_report(int configured);
+
+/* Global function definitions */
+
+/* Apply the Execution settings to this process. Called once at the end of
+ * startup, when the buffers the pipeline needs have been set up. */
+void ices_realtime_initialize(void) {
+	int configured = ices_config.scheduler != ices_scheduler_other_e
+		|| (ices_config.cpu_affinity && ices_config.cpu_affinity[0])
+		|| ices_config.lock_memory;
+
+	realtime_set_affinity();
+	realtime_set_scheduler();
+	realtime_lock_memory();
+	realtime_report(configured);
+}
+
+/* Private function definitions */
+
+static void realtime_set_scheduler(void) {
+#ifdef HAVE_SCHED_SETSCHEDULER
+	struct sched_param param;
+	int policy;
+
+	if (ices_config.scheduler == ices_scheduler_other_e)
+		return;
+
+	policy = ices_config.scheduler == ices_scheduler_fifo_e ? SCHED_FIFO : SCHED_RR;
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = ices_config.rt_priority;
+	if (param.sched_priority < sched_get_priority_min(policy))
+		param.sched_priority = sched_get_priority_min(policy);
+	else if (param.sched_priority > sched_get_priority_max(policy))
+		param.sched_priority = sched_get_priority_max(policy);
+
+#ifdef SCHED_RESET_ON_FORK
+	/* metadata updates and playlist scripts are forked off, they have no
+	 * business running real-time */
+	policy |= SCHED_RESET_ON_FORK;
+#endif
+
+	if (sched_setscheduler(0, policy, &param) < 0)
+		ices_log("Could not set real-time scheduling (%s), using the default scheduler",
+			 strerror(errno));
+#else
+	if (ices_config.scheduler != ices_scheduler_other_e)
+		ices_log("Real-time scheduling is not supported on this system");
+#endif
+}
+
+/* CPUAffinity is a list of CPUs and ranges, eg "1,3-4" */
+static void realtime_set_affinity(void) {
+#ifdef HAVE_SCHED_SETAFFINITY
+	cpu_set_t cpus;
+	char *s, *end;
+	long first, last;
+
+	if (!ices_config.cpu_affinity || !ices_config.cpu_affinity[0])
+		return;
+
+	CPU_ZERO(&cpus);
+	for (s = ices_config.cpu_affinity; *s; s = end) {
+		first = last = strtol(s, &end, 10);
+		if (end == s)
+			break;
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+		for (; first >= 0 && first <= last && first < CPU_SETSIZE; first++)
+			CPU_SET(first, &cpus);
+		while (*end == ',' || *end == ' ')
+			end++;
+	}
+
+	if (*s) {
+		ices_log("Invalid CPUAffinity %s, not pinning ices to any CPU", ices_config.cpu_affinity);
+		return;
+	}
+
+	if (sched_setaffinity(0, sizeof(cpus), &cpus) < 0)
+		ices_log("Could not set CPU affinity to %s: %s", ices_config.cpu_affinity,
+			 strerror(errno));
+#else
+	if (ices_config.cpu_affinity && ices_config.cpu_affinity[0])
+		ices_log("CPU affinity is not supported on this system");
+#endif
+}
+
+static void realtime_lock_memory(void) {
+	if (!ices_config.lock_memory)
+		return;
+
+	/* touch the sample buffers now rather than on the first track */
+	ices_stream_prefault();
+
+#ifdef HAVE_MLOCKALL
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0) {
+		ices_log("Could not lock ices in memory: %s", strerror(errno));
+		ices_config.lock_memory = 0;
+	}
+#else
+	ices_log("Memory locking is not supported on this system");
+	ices_config.lock_memory = 0;
+#endif
+}
+
+/* Log what we actually got, which may be less than was asked for */
+static void realtime_report(int configured) {
+	const char *scheduler = "other";
+	int priority = 0;
+	char cpus[256];
+#ifdef HAVE_SCHED_SETSCHEDULER
+	struct sched_param param;
+	int policy;
+#endif
+#ifdef HAVE_SCHED_SETAFFINITY
+	cpu_set_t set;
+	size_t len = 0;
+	int cpu;
+#endif
+
+#ifdef HAVE_SCHED_SETSCHEDULER
+	policy = sched_getscheduler(0);
+#ifdef SCHED_RESET_ON_FORK
+	if (policy >= 0)
+		policy &= ~SCHED_RESET_ON_FORK;
+#endif
+	if (policy == SCHED_FIFO)
+		scheduler = "fifo";
+	else if (policy == SCHED_RR)
+		scheduler = "rr";
+	if (sched_getparam(0, &param) == 0)
+		priority = param.sched_priority;
+#endif
+
+	snprintf(cpus, sizeof(cpus), "all");
+#ifdef HAVE_SCHED_SETAFFINITY
+	if (ices_config.cpu_affinity && sched_getaffinity(0, sizeof(set), &set) == 0) {
+		cpus[0] = '\0';
+		for (cpu = 0; cpu < CPU_SETSIZE && len < sizeof(cpus) - 8; cpu++)
+			if (CPU_ISSET(cpu, &set))
+				len += snprintf(cpus + len, sizeof(cpus) - len, "%s%d", len ? "," : "", cpu);
+	}
+#endif
+
+	if (configured)
+		ices_log("Scheduler: %s, priority %d, CPUs: %s, memory locked: %s", scheduler,
+			 priority, cpus, ices_config.lock_memory ? "yes" : "no");
+	else
+		ices_log_debug("Scheduler: %s, priority %d, CPUs: %s, memory locked: %s", scheduler,
+			       priority, cpus, ices_config.lock_memory ? "yes" : "no");
+
+	ices_stats_set("scheduler", "%s", scheduler);
+	ices_stats_set("scheduler_priority", "%d", priority);
+	ices_stats_set("cpu_affinity", "%s", cpus);
+	ices_stats_set("memory_locked", "%d", ices_config.lock_memory);
+}
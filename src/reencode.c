@@ -125,10 +125,16 @@ void ices_reencode_shutdown(void) {
 	ices_stream_t* stream;
 
 	for (stream = ices_config.streams; stream; stream = stream->next)
-		if (stream->encoder_state) {
-			lame_close((lame_global_flags*) stream->encoder_state);
-			stream->encoder_state = NULL;
-		}
+		ices_reencode_close(stream);
+}
+
+/* Release the encoder of a single stream, eg one dropped on reload. The
+ * next ices_reencode_reset sets up a fresh one if it is still needed. */
+void ices_reencode_close(ices_stream_t* stream) {
+	if (stream->encoder_state) {
+		lame_close((lame_global_flags*) stream->encoder_state);
+		stream->encoder_state = NULL;
+	}
 }
 
 /* decode buffer, of length buflen, into left and right. Stream-independent
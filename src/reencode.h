@@ -22,6 +22,7 @@
 void ices_reencode_initialize(void);
 void ices_reencode_shutdown(void);
 void ices_reencode_reset(input_stream_t* source);
+void ices_reencode_close(ices_stream_t* stream);
 int ices_reencode_decode(unsigned char* buf, size_t blen, size_t olen,
 			 int16_t* left, int16_t* right);
 int ices_reencode(ices_stream_t* stream, int nsamples, int16_t* left,
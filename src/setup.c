@@ -31,6 +31,14 @@ static void ices_setup_parse_config_file(ices_config_t *ices_config, const char
 static void ices_setup_parse_command_line(ices_config_t *ices_config, char **argv, int argc);
 static void ices_setup_parse_command_line_for_new_configfile(ices_config_t *ices_config, char **argv, int argc);
 static void ices_setup_activate_libshout_changes(const ices_config_t *ices_config);
+static void ices_setup_activate_stream(ices_stream_t* stream, int streamno);
+#ifdef HAVE_LIBXML
+static const char* ices_setup_find_config_file(const char *configfile, char *namespace, size_t len);
+#endif
+static int ices_setup_stream_same_mount(const ices_stream_t* a, const ices_stream_t* b);
+static int ices_setup_stream_unchanged(const ices_stream_t* old, const ices_stream_t* stream);
+static void ices_setup_free_stream(ices_stream_t* stream);
+static void ices_setup_release_stream(ices_stream_t* stream);
 static void ices_setup_usage(void);
 static void ices_setup_version(void);
 static void ices_setup_update_pidfile(int icespid);
@@ -39,6 +47,9 @@ static void ices_free_all(ices_config_t *ices_config);
 
 extern ices_config_t ices_config;
 
+/* set by SIGHUP, streams are reread before the next track */
+static volatile int reload_pending = 0;
+
 /* Global function definitions */
 
 /* Top level initialization function for ices.
@@ -56,7 +67,8 @@ void ices_setup_initialize(void) {
 	/* Parse the options in the config file, and the command line */
 	ices_setup_parse_options(&ices_config);
 
-	if (ices_config.daemon)
+	/* stations are detached (or not) by their supervisor */
+	if (ices_config.daemon && !ices_station_get_configfile())
 		ices_setup_daemonize();
 
 	/* Open logfiles */
@@ -87,6 +99,10 @@ void ices_setup_initialize(void) {
 			plugin->next = plugin->next->next;
 #endif
 
+	/* Scheduling, CPU pinning and memory locking, now that the pipeline
+	 * is set up */
+	ices_realtime_initialize();
+
 	ices_log_debug("Startup complete\n");
 }
 
@@ -115,6 +131,8 @@ void ices_setup_shutdown(int exitCode) {
 	/* Cleanup the cue file (the cue module has no init yet) */
 	ices_cue_shutdown();
 
+	ices_stats_shutdown();
+
 	/* Make sure we're not leaving any memory allocated around when
 	 * we exit. This makes it easier to find memory leaks, and
 	 * some systems actually don't clean up that well */
@@ -132,6 +150,117 @@ void ices_setup_shutdown(int exitCode) {
 	exit(exitCode);
 }
 
+/* Ask for the streams to be reread from the config file. Safe to call
+ * from a signal handler, the work is done by ices_setup_reload. */
+void ices_setup_schedule_reload(void) {
+	reload_pending = 1;
+}
+
+/* Bring the running streams in line with the config file, if a reload was
+ * scheduled. Called by the stream loop between tracks. Streams are matched
+ * on host, port and mountpoint: unchanged streams keep their connection
+ * and encoder so their listeners don't notice anything, changed ones are
+ * reconnected with the new settings, new ones are connected and get an
+ * encoder as the next track starts, and vanished ones are shut down. */
+void ices_setup_reload(void) {
+#ifdef HAVE_LIBXML
+	ices_config_t reload;
+	char namespace[1024];
+	const char *configfile;
+	ices_stream_t *stream, *old, *next;
+	ices_stream_t **prev;
+	int kept = 0, changed = 0, added = 0, removed = 0;
+	int streamno = 0;
+
+	if (!reload_pending)
+		return;
+	reload_pending = 0;
+
+	if (!(configfile = ices_setup_find_config_file(ices_config.configfile, namespace,
+						       sizeof(namespace)))) {
+		ices_log("Cannot reload streams: config file %s not found", ices_config.configfile);
+		return;
+	}
+
+	memset(&reload, 0, sizeof(reload));
+	if (!(reload.streams = (ices_stream_t*) malloc(sizeof(ices_stream_t)))) {
+		ices_log("Cannot reload streams: out of memory");
+		return;
+	}
+	ices_setup_parse_stream_defaults(reload.streams);
+
+	if (!ices_xml_parse_config_streams(&reload, configfile)) {
+		ices_log("Error reloading streams from %s (%s), keeping the current ones",
+			 configfile, ices_log_get_error());
+		for (stream = reload.streams; stream; stream = next) {
+			next = stream->next;
+			ices_setup_free_stream(stream);
+			ices_util_free(stream);
+		}
+		return;
+	}
+
+	for (stream = reload.streams; stream; stream = stream->next, streamno++) {
+		for (prev = &ices_config.streams; *prev; prev = &(*prev)->next)
+			if (ices_setup_stream_same_mount(*prev, stream))
+				break;
+
+		if ((old = *prev)) {
+			*prev = old->next;
+			old->next = NULL;
+		}
+
+		if (old && ices_setup_stream_unchanged(old, stream)) {
+			/* take over the live connection and encoder */
+			stream->conn = old->conn;
+			stream->encoder_state = old->encoder_state;
+			stream->connect_delay = old->connect_delay;
+			stream->out_samplerate = old->out_samplerate;
+			old->conn = NULL;
+			old->encoder_state = NULL;
+			kept++;
+		} else {
+			if (!(stream->conn = shout_new())) {
+				ices_log("Could not create shout interface");
+				ices_setup_shutdown(ICES_EXIT_FAILURE);
+			}
+			ices_setup_activate_stream(stream, streamno);
+
+			if (old) {
+				ices_log("Stream %s changed, reconnecting", ices_util_nullcheck(stream->mount));
+				changed++;
+			} else {
+				ices_log("Adding stream %s", ices_util_nullcheck(stream->mount));
+				added++;
+			}
+		}
+
+		if (old)
+			ices_setup_release_stream(old);
+	}
+
+	/* whatever is left wasn't in the config file any more */
+	for (stream = ices_config.streams; stream; stream = next) {
+		next = stream->next;
+		ices_log("Removing stream %s", ices_util_nullcheck(stream->mount));
+		ices_setup_release_stream(stream);
+		removed++;
+	}
+
+	ices_config.streams = reload.streams;
+
+#ifdef HAVE_LIBLAME
+	/* a new stream may be the first to need reencoding */
+	ices_reencode_initialize();
+#endif
+
+	ices_log("Reloaded streams from %s: %d unchanged, %d changed, %d added, %d removed",
+		 configfile, kept, changed, added, removed);
+#else
+	reload_pending = 0;
+#endif
+}
+
 /* Local function definitions */
 
 /* Top level option parsing function.
@@ -164,6 +293,11 @@ static void ices_setup_parse_defaults(ices_config_t *ices_config) {
 	ices_config->verbose = ICES_DEFAULT_VERBOSE;
 	ices_config->reencode = ICES_DEFAULT_REENCODE;
 	ices_config->cuefile = ICES_DEFAULT_CUEFILE;
+	ices_config->stats = ICES_DEFAULT_STATS;
+	ices_config->scheduler = ICES_DEFAULT_SCHEDULER;
+	ices_config->rt_priority = ICES_DEFAULT_RT_PRIORITY;
+	ices_config->cpu_affinity = NULL;
+	ices_config->lock_memory = ICES_DEFAULT_LOCK_MEMORY;
 
 	ices_config->pm.playlist_file =
 		ices_util_strdup(ICES_DEFAULT_PLAYLIST_FILE);
@@ -228,6 +362,7 @@ static void ices_free_all(ices_config_t *ices_config) {
 
 	ices_util_free(ices_config->configfile);
 	ices_util_free(ices_config->base_directory);
+	ices_util_free(ices_config->cpu_affinity);
 
 	ices_util_free(ices_config->pm.playlist_file);
 	ices_util_free(ices_config->pm.module);
@@ -240,22 +375,69 @@ static void ices_free_all(ices_config_t *ices_config) {
 	}
 }
 
+/* Streams are the same mount if they go to the same place */
+static int ices_setup_stream_same_mount(const ices_stream_t* a, const ices_stream_t* b) {
+	return a->port == b->port && !ices_util_strcmp_null(a->host, b->host)
+		&& !ices_util_strcmp_null(a->mount, b->mount);
+}
+
+/* Compare every setting of a running stream with its reloaded version */
+static int ices_setup_stream_unchanged(const ices_stream_t* old, const ices_stream_t* stream) {
+	if (ices_util_strcmp_null(old->user, stream->user)
+	    || ices_util_strcmp_null(old->password, stream->password)
+	    || ices_util_strcmp_null(old->dumpfile, stream->dumpfile)
+	    || ices_util_strcmp_null(old->name, stream->name)
+	    || ices_util_strcmp_null(old->genre, stream->genre)
+	    || ices_util_strcmp_null(old->description, stream->description)
+	    || ices_util_strcmp_null(old->url, stream->url))
+		return 0;
+
+	if (old->protocol != stream->protocol || old->ispublic != stream->ispublic
+	    || old->reencode != stream->reencode || old->bitrate != stream->bitrate
+	    || old->out_numchannels != stream->out_numchannels)
+		return 0;
+
+	/* the encoder fills in its sample rate if none was configured */
+	if (stream->out_samplerate > 0 && old->out_samplerate != stream->out_samplerate)
+		return 0;
+	if (stream->out_samplerate <= 0 && old->out_samplerate > 0 && !old->encoder_state)
+		return 0;
+
+	return 1;
+}
+
+/* Disconnect a stream that is no longer in use and free it */
+static void ices_setup_release_stream(ices_stream_t* stream) {
+	if (stream->conn)
+		shout_close(stream->conn);
+#ifdef HAVE_LIBLAME
+	ices_reencode_close(stream);
+#endif
+	ices_setup_free_stream(stream);
+	ices_util_free(stream);
+}
+
 #ifdef HAVE_LIBXML
+/* Find configfile as given or in the system config directory. Returns
+ * NULL if it can't be read. */
+static const char* ices_setup_find_config_file(const char *configfile, char *namespace, size_t len) {
+	if (ices_util_verify_file(configfile))
+		return configfile;
+
+	snprintf(namespace, len, "%s/%s", ICES_ETCDIR, configfile);
+	if (ices_util_verify_file(namespace))
+		return namespace;
+
+	return NULL;
+}
+
 /* Tell the xml module to parse the config file. */
 static void ices_setup_parse_config_file(ices_config_t *ices_config, const char *configfile) {
 	char namespace[1024];
-	const char *realname = NULL;
+	const char *realname;
 	int ret;
 
-	if (ices_util_verify_file(configfile))
-		realname = configfile;
-	else {
-		sprintf(namespace, "%s/%s", ICES_ETCDIR, configfile);
-		if (ices_util_verify_file(namespace))
-			realname = &namespace[0];
-	}
-
-	if (realname) {
+	if ((realname = ices_setup_find_config_file(configfile, namespace, sizeof(namespace)))) {
 		ret = ices_xml_parse_config_file(ices_config, realname);
 
 		if (ret == -1)
@@ -271,9 +453,17 @@ static void ices_setup_parse_config_file(ices_config_t *ices_config, const char
 /* This function looks through the command line options for a new
  * configfile. */
 static void ices_setup_parse_command_line_for_new_configfile(ices_config_t *ices_config, char **argv, int argc) {
+	const char *station;
 	int arg;
 	char *s;
 
+	/* a station forked by the supervisor reads only its own config file */
+	if ((station = ices_station_get_configfile())) {
+		ices_util_free(ices_config->configfile);
+		ices_config->configfile = ices_util_strdup(station);
+		return;
+	}
+
 	arg = 1;
 
 	while (arg < argc) {
@@ -474,57 +664,59 @@ static void ices_setup_parse_command_line(ices_config_t *ices_config, char **arg
    libshout object. */
 static void ices_setup_activate_libshout_changes(const ices_config_t *ices_config) {
 	ices_stream_t* stream;
-	shout_t* conn;
 	int streamno = 0;
+
+	for (stream = ices_config->streams; stream; stream = stream->next)
+		ices_setup_activate_stream(stream, streamno++);
+}
+
+/* Copy the configuration of one stream to its libshout object */
+static void ices_setup_activate_stream(ices_stream_t* stream, int streamno) {
+	shout_t* conn = stream->conn;
 	char useragent[64];
 	char bitrate[8];
 
 	snprintf(useragent, sizeof(useragent), "ices/" VERSION " libshout/%s",
 		 shout_version(NULL, NULL, NULL));
 
-	for (stream = ices_config->streams; stream; stream = stream->next) {
-		conn = stream->conn;
-
-		shout_set_host(conn, stream->host);
-		shout_set_port(conn, stream->port);
-		shout_set_user(conn, stream->user);
-		shout_set_password(conn, stream->password);
-		shout_set_format(conn, SHOUT_FORMAT_MP3);
-		if (stream->protocol == icy_protocol_e)
-			shout_set_protocol(conn, SHOUT_PROTOCOL_ICY);
-		else if (stream->protocol == http_protocol_e)
-			shout_set_protocol(conn, SHOUT_PROTOCOL_HTTP);
-		else
-			shout_set_protocol(conn, SHOUT_PROTOCOL_XAUDIOCAST);
-		if (stream->dumpfile)
-			shout_set_dumpfile(conn, stream->dumpfile);
-		shout_set_name(conn, stream->name);
-		shout_set_url(conn, stream->url);
-		shout_set_genre(conn, stream->genre);
-		shout_set_description(conn, stream->description);
-
-		snprintf(bitrate, sizeof(bitrate), "%d", stream->bitrate);
-		shout_set_audio_info(conn, SHOUT_AI_BITRATE, bitrate);
-
-		shout_set_public(conn, stream->ispublic);
-		shout_set_mount(conn, stream->mount);
-		shout_set_agent(conn, useragent);
-
-		ices_log_debug("Sending following information to libshout:");
-		ices_log_debug("Stream: %d", streamno);
-		ices_log_debug("Host: %s:%d (protocol: %s)", shout_get_host(conn),
-			       shout_get_port(conn),
-			       stream->protocol == icy_protocol_e ? "icy" :
-			       stream->protocol == http_protocol_e ? "http" : "xaudiocast");
-		ices_log_debug("Mount: %s, User: %s, Password: %s", shout_get_mount(conn), shout_get_user(conn), shout_get_password(conn));
-		ices_log_debug("Name: %s\tURL: %s", shout_get_name(conn), shout_get_url(conn));
-		ices_log_debug("Genre: %s\tDesc: %s", shout_get_genre(conn),
-			       shout_get_description(conn));
-		ices_log_debug("Bitrate: %s\tPublic: %d", shout_get_audio_info(conn, SHOUT_AI_BITRATE),
-			       shout_get_public(conn));
-		ices_log_debug("Dump file: %s", ices_util_nullcheck(shout_get_dumpfile(conn)));
-		streamno++;
-	}
+	shout_set_host(conn, stream->host);
+	shout_set_port(conn, stream->port);
+	shout_set_user(conn, stream->user);
+	shout_set_password(conn, stream->password);
+	shout_set_format(conn, SHOUT_FORMAT_MP3);
+	if (stream->protocol == icy_protocol_e)
+		shout_set_protocol(conn, SHOUT_PROTOCOL_ICY);
+	else if (stream->protocol == http_protocol_e)
+		shout_set_protocol(conn, SHOUT_PROTOCOL_HTTP);
+	else
+		shout_set_protocol(conn, SHOUT_PROTOCOL_XAUDIOCAST);
+	if (stream->dumpfile)
+		shout_set_dumpfile(conn, stream->dumpfile);
+	shout_set_name(conn, stream->name);
+	shout_set_url(conn, stream->url);
+	shout_set_genre(conn, stream->genre);
+	shout_set_description(conn, stream->description);
+
+	snprintf(bitrate, sizeof(bitrate), "%d", stream->bitrate);
+	shout_set_audio_info(conn, SHOUT_AI_BITRATE, bitrate);
+
+	shout_set_public(conn, stream->ispublic);
+	shout_set_mount(conn, stream->mount);
+	shout_set_agent(conn, useragent);
+
+	ices_log_debug("Sending following information to libshout:");
+	ices_log_debug("Stream: %d", streamno);
+	ices_log_debug("Host: %s:%d (protocol: %s)", shout_get_host(conn),
+		       shout_get_port(conn),
+		       stream->protocol == icy_protocol_e ? "icy" :
+		       stream->protocol == http_protocol_e ? "http" : "xaudiocast");
+	ices_log_debug("Mount: %s, User: %s, Password: %s", shout_get_mount(conn), shout_get_user(conn), shout_get_password(conn));
+	ices_log_debug("Name: %s\tURL: %s", shout_get_name(conn), shout_get_url(conn));
+	ices_log_debug("Genre: %s\tDesc: %s", shout_get_genre(conn),
+		       shout_get_description(conn));
+	ices_log_debug("Bitrate: %s\tPublic: %d", shout_get_audio_info(conn, SHOUT_AI_BITRATE),
+		       shout_get_public(conn));
+	ices_log_debug("Dump file: %s", ices_util_nullcheck(shout_get_dumpfile(conn)));
 }
 
 /* Display all command line options for ices */
@@ -535,7 +727,7 @@ static void ices_setup_usage(void) {
 	       "\t-B (Background (daemon mode))\n"
 	       "\t-b <stream bitrate>\n"
 	       "\t-C <crossfade seconds>\n");
-	printf("\t-c <configfile>\n");
+	printf("\t-c <configfile> (repeat to run one station per file)\n");
 	printf("\t-D <base directory>\n");
 	printf("\t-d <stream description>\n");
 	printf("\t-f <dumpfile on server>\n");
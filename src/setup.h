@@ -21,6 +21,8 @@
 /* Public function declarations */
 void ices_setup_initialize(void);
 void ices_setup_shutdown(int exitCode);
+void ices_setup_schedule_reload(void);
+void ices_setup_reload(void);
 
 /* exported for the config parser */
 void ices_setup_parse_stream_defaults(ices_stream_t*);
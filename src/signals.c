@@ -89,11 +89,13 @@ static RETSIGTYPE signals_int(const int sig) {
 	ices_setup_shutdown(EXIT_SUCCESS);
 }
 
-/* SIGHUP caught, let's cycle logfiles and try to reload the playlist module */
+/* SIGHUP caught, let's cycle logfiles, try to reload the playlist module
+ * and reread the streams before the next track */
 static RETSIGTYPE signals_hup(const int sig) {
 	ices_log_debug("Caught SIGHUP, cycling logfiles and reloading playlist...");
 	ices_log_reopen_logfile();
 	ices_playlist_reload();
+	ices_setup_schedule_reload();
 }
 
 /* I'm not sure whether I'll keep this... */
@@ -0,0 +1,259 @@
+/* station.c
+ * - Run several independent stations from one ices invocation
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ */
+
+/* Each -c option on the command line describes one station. With more
+ * than one, the first process becomes a small supervisor which forks one
+ * ices per config file and restarts it if it dies. Stations share the
+ * binary, the loaded libraries and anything set up before the fork
+ * copy-on-write, but keep their playlist, pipeline and log apart, just
+ * as if they had been started separately. */
+
+#include "definitions.h"
+
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#ifdef HAVE_SIGNAL_H
+#include <signal.h>
+#endif
+
+#include <time.h>
+
+/* don't restart a station more often than this (seconds) */
+#define STATION_RESPAWN_DELAY 5
+
+typedef struct {
+	const char* configfile;
+	pid_t pid;
+	time_t started;
+} station_t;
+
+static station_t* Stations = NULL;
+static int NStations = 0;
+/* config file of this station, if we were forked by the supervisor */
+static const char* Configfile = NULL;
+
+static volatile sig_atomic_t stopping = 0;
+
+/* Private function declarations */
+static void station_supervise(void);
+static int station_spawn(station_t* station);
+static void station_signal_all(int sig);
+static void station_daemonize(void);
+static RETSIGTYPE station_signal_stop(const int sig);
+static RETSIGTYPE station_signal_forward(const int sig);
+
+/* Global function definitions */
+
+/* Look for several config files on the command line. If there are, this
+ * only returns in the forked stations. */
+void ices_station_initialize(void) {
+	char** argv = ices_util_get_argv();
+	int argc = ices_util_get_argc();
+	int daemon = 0;
+	int arg;
+
+	for (arg = 1; arg < argc; arg++) {
+		if (argv[arg][0] != '-')
+			continue;
+		if (argv[arg][1] == 'c' && arg + 1 < argc)
+			NStations++;
+		else if (argv[arg][1] == 'B')
+			daemon = 1;
+	}
+
+	if (NStations < 2) {
+		NStations = 0;
+		return;
+	}
+
+	if (!(Stations = (station_t*) calloc(NStations, sizeof(station_t)))) {
+		fprintf(stderr, "Could not allocate station table\n");
+		exit(ICES_EXIT_FAILURE);
+	}
+
+	NStations = 0;
+	for (arg = 1; arg < argc - 1; arg++)
+		if (argv[arg][0] == '-' && argv[arg][1] == 'c')
+			Stations[NStations++].configfile = argv[++arg];
+
+	if (daemon)
+		station_daemonize();
+
+	station_supervise();
+}
+
+/* The config file this station should read, or NULL when running as a
+ * single, unsupervised ices. */
+const char* ices_station_get_configfile(void) {
+	return Configfile;
+}
+
+/* Private function definitions */
+
+static void station_supervise(void) {
+	struct sigaction sa;
+	station_t* station;
+	pid_t pid;
+	int status;
+	int running;
+	int i;
+
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;
+
+	sa.sa_handler = SIG_IGN;
+	sigaction(SIGPIPE, &sa, NULL);
+
+	sa.sa_handler = station_signal_stop;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	sa.sa_handler = station_signal_forward;
+	sigaction(SIGHUP, &sa, NULL);
+	sigaction(SIGUSR1, &sa, NULL);
+
+	ices_log("Supervising %d stations", NStations);
+
+	for (i = 0; i < NStations; i++)
+		if (station_spawn(&Stations[i]) == 0)
+			/* this is the new station */
+			return;
+
+	running = NStations;
+	while (running) {
+		if ((pid = waitpid(-1, &status, 0)) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		for (station = NULL, i = 0; i < NStations; i++)
+			if (Stations[i].pid == pid)
+				station = &Stations[i];
+		if (!station)
+			continue;
+
+		station->pid = 0;
+		if (stopping) {
+			running--;
+			continue;
+		}
+
+		if (WIFSIGNALED(status))
+			ices_log("Station %s killed by signal %d, restarting", station->configfile,
+				 WTERMSIG(status));
+		else
+			ices_log("Station %s exited with status %d, restarting", station->configfile,
+				 WEXITSTATUS(status));
+
+		if (time(NULL) - station->started < STATION_RESPAWN_DELAY)
+			sleep(STATION_RESPAWN_DELAY);
+
+		if (!stopping && station_spawn(station) == 0)
+			return;
+		if (!station->pid)
+			running--;
+	}
+
+	ices_log("All stations stopped, supervisor exiting");
+	exit(ICES_EXIT_SUCCESS);
+}
+
+/* Fork a station. Returns 0 in the new station, the pid in the supervisor
+ * and -1 if the fork failed. */
+static int station_spawn(station_t* station) {
+	struct sigaction sa;
+	pid_t pid;
+
+	station->started = time(NULL);
+	/* don't let the station repeat whatever we still have buffered */
+	fflush(stdout);
+	fflush(stderr);
+
+	if ((pid = fork()) < 0) {
+		ices_log("Could not fork station %s: %s", station->configfile, strerror(errno));
+		return -1;
+	}
+
+	if (pid) {
+		station->pid = pid;
+		ices_log("Started station %s (pid %d)", station->configfile, (int) pid);
+		return pid;
+	}
+
+	/* undo the supervisor's handlers, ices_signals_setup installs ours */
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0;
+	sa.sa_handler = SIG_DFL;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	sigaction(SIGHUP, &sa, NULL);
+	sigaction(SIGUSR1, &sa, NULL);
+
+	Configfile = station->configfile;
+	free(Stations);
+	Stations = NULL;
+	NStations = 0;
+
+	return 0;
+}
+
+static void station_signal_all(int sig) {
+	int i;
+
+	for (i = 0; i < NStations; i++)
+		if (Stations[i].pid > 0)
+			kill(Stations[i].pid, sig);
+}
+
+/* Detach the supervisor. Stations inherit the detached session. */
+static void station_daemonize(void) {
+	pid_t pid = fork();
+
+	if (pid == -1) {
+		ices_log("ERROR: Cannot fork(), that means no daemon, sorry!");
+		return;
+	}
+
+	if (pid) {
+		printf("Into the land of the dreaded daemons we go... (pid: %d)\n", (int) pid);
+		exit(ICES_EXIT_SUCCESS);
+	}
+
+#ifdef HAVE_SETSID
+	setsid();
+#endif
+
+	freopen("/dev/null", "r", stdin);
+	freopen("/dev/null", "w", stdout);
+	freopen("/dev/null", "w", stderr);
+}
+
+/* SIGINT/SIGTERM: take every station down with us */
+static RETSIGTYPE station_signal_stop(const int sig) {
+	stopping = 1;
+	station_signal_all(SIGTERM);
+}
+
+/* SIGHUP and SIGUSR1 mean the same for every station */
+static RETSIGTYPE station_signal_forward(const int sig) {
+	station_signal_all(sig);
+}
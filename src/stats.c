@@ -0,0 +1,162 @@
+/* stats.c
+ * - Functions for the statistics file in ices
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ */
+
+#include "definitions.h"
+
+#include <time.h>
+
+extern ices_config_t ices_config;
+
+/* Syntax of stats file, one value per line:
+ * key=value
+ *
+ * Modules set whatever they want to report; the file is rewritten (via a
+ * temporary file, so readers never see half of it) at most once a second
+ * while streaming. */
+
+typedef struct stats_entry_St {
+	char *key;
+	char value[128];
+	long count;
+	struct stats_entry_St *next;
+} stats_entry_t;
+
+static stats_entry_t *Entries = NULL;
+static time_t LastUpdate = 0;
+
+/* Private function declarations */
+static stats_entry_t *ices_stats_find(const char *key);
+static void ices_stats_write(void);
+
+/* Global function definitions */
+
+/* Set key to a printf-style value */
+void ices_stats_set(const char *key, const char *fmt, ...) {
+	stats_entry_t *entry;
+	va_list ap;
+
+	if (!(entry = ices_stats_find(key)))
+		return;
+
+	va_start(ap, fmt);
+	vsnprintf(entry->value, sizeof(entry->value), fmt, ap);
+	va_end(ap);
+}
+
+/* Add delta to a counter */
+void ices_stats_add(const char *key, long delta) {
+	stats_entry_t *entry;
+
+	if (!(entry = ices_stats_find(key)))
+		return;
+
+	entry->count += delta;
+	snprintf(entry->value, sizeof(entry->value), "%ld", entry->count);
+}
+
+/* Rewrite the stats file if it is more than a second old */
+void ices_stats_update(void) {
+	time_t now;
+
+	if (!ices_config.stats)
+		return;
+
+	now = time(NULL);
+	if (now == LastUpdate)
+		return;
+	LastUpdate = now;
+
+	ices_stats_write();
+}
+
+/* Remove the stats file and forget all values */
+void ices_stats_shutdown(void) {
+	stats_entry_t *entry, *next;
+	const char *filename;
+
+	if (ices_config.stats && (filename = ices_stats_get_filename()))
+		remove(filename);
+
+	for (entry = Entries; entry; entry = next) {
+		next = entry->next;
+		ices_util_free(entry->key);
+		ices_util_free(entry);
+	}
+	Entries = NULL;
+}
+
+/* Return the name of the stats file */
+const char *ices_stats_get_filename(void) {
+	static char buf[1024];
+
+	if (!ices_config.base_directory) {
+		ices_log_error("Base directory is invalid");
+		return NULL;
+	}
+
+	snprintf(buf, sizeof(buf), "%s/ices.stats", ices_config.base_directory);
+
+	return buf;
+}
+
+/* Private function definitions */
+
+/* Look up key, adding it at the end if it's new so the file keeps the
+ * order in which values first appeared */
+static stats_entry_t *ices_stats_find(const char *key) {
+	stats_entry_t **entry;
+
+	for (entry = &Entries; *entry; entry = &(*entry)->next)
+		if (!strcmp((*entry)->key, key))
+			return *entry;
+
+	if (!(*entry = (stats_entry_t*) calloc(1, sizeof(stats_entry_t))))
+		return NULL;
+	if (!((*entry)->key = ices_util_strdup(key))) {
+		ices_util_free(*entry);
+		*entry = NULL;
+		return NULL;
+	}
+
+	return *entry;
+}
+
+static void ices_stats_write(void) {
+	char tmpname[1032];
+	const char *filename;
+	stats_entry_t *entry;
+	FILE *fp;
+
+	if (!(filename = ices_stats_get_filename()))
+		return;
+
+	snprintf(tmpname, sizeof(tmpname), "%s.tmp", filename);
+	if (!(fp = ices_util_fopen_for_writing(tmpname))) {
+		ices_log("Could not open stats file [%s] for writing, stats not updated!", tmpname);
+		return;
+	}
+
+	for (entry = Entries; entry; entry = entry->next)
+		fprintf(fp, "%s=%s\n", entry->key, entry->value);
+
+	ices_util_fclose(fp);
+
+	if (rename(tmpname, filename) < 0)
+		ices_log_debug("Could not rename %s to %s: %s", tmpname, filename, strerror(errno));
+}
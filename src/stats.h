@@ -0,0 +1,25 @@
+/* stats.h
+ * - Statistics file function declarations for ices
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ */
+
+/* Public function declarations */
+void ices_stats_set(const char *key, const char *fmt, ...);
+void ices_stats_add(const char *key, long delta);
+void ices_stats_update(void);
+void ices_stats_shutdown(void);
+const char *ices_stats_get_filename(void);
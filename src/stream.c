@@ -62,6 +62,10 @@ typedef struct {
 
 static volatile int finish_send = 0;
 
+/* worst case decode: 22050 Hz at 8kbs = 44.1 samples/byte */
+static int16_t left[INPUT_BUFSIZ * 45];
+static int16_t right[INPUT_BUFSIZ * 45];
+
 /* Private function declarations */
 static int stream_connect(ices_stream_t* stream);
 static int stream_send(ices_config_t* config, input_stream_t* source);
@@ -82,6 +86,9 @@ void ices_stream_loop(ices_config_t* config) {
 	time_t now;
 
 	while (1) {
+		/* pick up stream changes from SIGHUP between tracks */
+		ices_setup_reload();
+
 		source.path = ices_playlist_get_next();
 
 		if (!(source.path && source.path[0])) {
@@ -151,6 +158,13 @@ void ices_stream_next(void) {
 	finish_send = 1;
 }
 
+/* Fault in the sample buffers before streaming starts, so the first
+ * track doesn't take the page faults */
+void ices_stream_prefault(void) {
+	memset(left, 0, sizeof(left));
+	memset(right, 0, sizeof(right));
+}
+
 /* This function is called to stream a single file */
 static int stream_send(ices_config_t* config, input_stream_t* source) {
 	ices_stream_t* stream;
@@ -162,9 +176,6 @@ static int stream_send(ices_config_t* config, input_stream_t* source) {
 	int samples;
 	int rc;
 	int do_sleep;
-	/* worst case decode: 22050 Hz at 8kbs = 44.1 samples/byte */
-	static int16_t left[INPUT_BUFSIZ * 45];
-	static int16_t right[INPUT_BUFSIZ * 45];
 #ifdef HAVE_LIBLAME
 	int decode = 0;
 	buffer_t obuf;
@@ -320,6 +331,7 @@ static int stream_send(ices_config_t* config, input_stream_t* source) {
 			}
 		}
 		ices_cue_update(source);
+		ices_stats_update();
 		if ( source->interrupttime && time(NULL)>=source->interrupttime ) finish_send = 1;
 	}
 
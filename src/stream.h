@@ -21,3 +21,4 @@
 /* Public function declarations */
 void ices_stream_loop(ices_config_t* config);
 void ices_stream_next(void);
+void ices_stream_prefault(void);
@@ -223,6 +223,13 @@ const char *ices_util_nullcheck(const char *string) {
 	return string;
 }
 
+/* strcmp which takes NULL as an empty value */
+int ices_util_strcmp_null(const char *a, const char *b) {
+	if (!a || !b)
+		return (a != NULL) - (b != NULL);
+	return strcmp(a, b);
+}
+
 /* Wrapper function for percentage */
 double ices_util_percent(int num, int den) {
 	if (!den)
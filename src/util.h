@@ -37,6 +37,7 @@ int ices_util_is_regular_file(int fd);
 int ices_util_directory_create(const char *filename);
 int ices_util_directory_exists(const char *filename);
 const char *ices_util_nullcheck(const char *string);
+int ices_util_strcmp_null(const char *a, const char *b);
 double ices_util_percent(int this, int of_that);
 char *ices_util_file_time(unsigned int bitrate, unsigned int filesize,
 			  char *namespace);